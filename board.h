@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _board_h_
+#define _board_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Event from one of the boards in multi-board capture. Time is in nanoseconds
+ * of the host clock since the beginning of capture. Compact events are already
+ * expanded to full events.
+ */
+struct board_record
+{
+    uint64_t time;
+    uint32_t board;
+    uint32_t event;
+    uint32_t param;
+};
+
+// Size of the record in merged output file: time, board, event and param, little endian.
+#define BOARD_RECORD_FILE_SIZE 20
+
+/*
+ * Returns true if full (not compact) event carries 24-bit time stamp. Events
+ * after EV_KEEPALIVE up to 0x7F have no time stamp.
+ */
+static inline bool event_has_time_stamp(uint32_t event)
+{
+    uint32_t id = event & 0xFF000000;
+
+    return (id > 0x0F000000 && id <= 0x71000000) || id >= 0x80000000;
+}
+
+
+/*
+ * Converts target time stamps of one board into the host time. Upper bits of
+ * 24-bit time stamps are restored from wraps. Offset between target and host
+ * time is the minimum of differences between host receive time and target time
+ * of the newest event. Receive time is always later than the event, so the
+ * minimum is the closest estimate. Minimum is taken from the current and the
+ * previous window, so crystal drift is followed.
+ */
+struct board_clock
+{
+    uint32_t board;
+    // Target time in ticks since the reset.
+    uint64_t ticks;
+    uint32_t frequency;
+    // Number of wraps was lost, e.g. by overflow.
+    bool ticks_unknown;
+    bool delta_base_valid;
+    // Offset in nanoseconds from target time to host time.
+    int64_t offset;
+    int64_t window_min;
+    int64_t prev_window_min;
+    uint64_t window_start;
+    // Host time of the last record, records from one board never go back in time.
+    uint64_t last_time;
+};
+
+void board_clock_init(struct board_clock *clock, uint32_t board);
+bool board_clock_event(struct board_clock *clock, uint32_t event, uint32_t param,
+    uint64_t receive_time, struct board_record *record);
+uint64_t board_clock_target_time(const struct board_clock *clock);
+
+
+/*
+ * Queue of records received from one board, waiting for merge.
+ */
+struct board_queue
+{
+    struct board_record *records;
+    size_t head;
+    size_t tail;
+    size_t capacity;
+};
+
+void board_queue_push(struct board_queue *queue, const struct board_record *record);
+void board_queue_free(struct board_queue *queue);
+
+static inline bool board_queue_empty(struct board_queue *queue)
+{
+    return queue->head == queue->tail;
+}
+
+static inline struct board_record *board_queue_front(struct board_queue *queue)
+{
+    return &queue->records[queue->head];
+}
+
+static inline void board_queue_pop(struct board_queue *queue)
+{
+    queue->head++;
+}
+
+void board_record_write(FILE *output, const struct board_record *record);
+
+#endif
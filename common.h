@@ -12,10 +12,13 @@
  *
  * This event is placed at the end of RTT buffer, so it is send each time
  * RTT buffer cycles back to the beginning.
- * @param additional Unused
- * @param param      If CONFIG_RTT_LITE_TRACE_FAST_OVERFLOW_CHECK is set then
- *         it contains 1 on bit 0 and RTT buffer cycle counter on the rest of
- *         bits. Else it contains minimum free space of RTT buffer if
+ * @param additional If CONFIG_RTT_LITE_TRACE_FLIGHT_RECORDER is set then
+ *         it contains current write index of RTT buffer, so the newest
+ *         event can be found in the RAM dump. Unused otherwise.
+ * @param param      If CONFIG_RTT_LITE_TRACE_FAST_OVERFLOW_CHECK or
+ *         CONFIG_RTT_LITE_TRACE_FLIGHT_RECORDER is set then it contains 1 on
+ *         bit 0 and RTT buffer cycle counter on the rest of bits. Else it
+ *         contains minimum free space of RTT buffer if
  *         CONFIG_RTT_LITE_TRACE_BUFFER_STATS is set.
  */
 #define EV_CYCLE 0x01000000
@@ -143,9 +146,20 @@
  *     t - time stamp
  */
 
+/** @brief Event send when the runtime class mask was changed.
+ *
+ * Events from classes that have cleared bit in the mask are not send until
+ * the mask changes again.
+ *
+ * @param param      New class mask. Bit n enables RTT_LITE_TRACE_CLASS_xyz
+ *         with value n.
+ */
+#define EV_CLASS_MASK 0x10000000
+
 /** @brief Event send as the first event after the system reset.
  * 
- * @param param      Unused.
+ * @param param      Time stamp frequency in Hz. Older versions send zero and
+ *         they always use 16MHz.
  */
 #define EV_SYSTEM_RESET 0x11000000
 
@@ -248,16 +262,89 @@
  */
 #define EV_PRINT 0x1F000000
 
+/** @brief Event with binary payload sent by rtt_lite_trace_blob().
+ *
+ * It is placed after the user events and it has time stamp like them.
+ * Buffer with the payload is send immediately after this event.
+ *
+ * @param param       Blob id.
+ */
+#define EV_BLOB 0x70000000
+
+/** @brief Event send by the timer interrupt if there was no event with
+ *  time stamp for a quarter of the timer period.
+ *
+ * It allows the receiving part to count all timer wraps during long idle
+ * periods. Sent only if CONFIG_RTT_LITE_TRACE_KEEPALIVE is set.
+ *
+ * @param param       Unused.
+ */
+#define EV_KEEPALIVE 0x71000000
+
 /** @brief Event send periodically to allow synchronization of the stream.
  * 
  * Each byte of the event is not a valid event id, so it gives the hint to the
- * parser that this is a synchronization event.
+ * parser that this is a synchronization event. Ids 0x78..0x7F are reserved
+ * for these bytes and must not be assigned to other events.
  * 
  * @param additional  Always SYNC_ADDITIONAL.
  * @param param       Always SYNC_PARAM.
  */
 #define EV_SYNC_FIRST 0x78000000
 
+/** @brief Event reporting number of ISR calls when ISR sampling is enabled.
+ *
+ * It is send periodically for each ISR that was called since the last report.
+ * Only 1 of rate calls has EV_ISR_ENTER and EV_ISR_EXIT events.
+ *
+ * @param additional Bits 0:6 - ISR number. Bits 8:23 - sampling rate.
+ * @param param      Number of ISR calls since the last report, including
+ *         the calls that were not traced.
+ */
+#define EV_ISR_COUNT 0x72000000
+
+/** @brief Event reporting new maximum of thread stack usage.
+ *
+ * It is send when the incremental stack scan on the target finds that the
+ * stack was used more than reported before.
+ *
+ * @param additional Maximum number of bytes used on the stack.
+ * @param param      Thread id.
+ */
+#define EV_STACK_USAGE 0x73000000
+
+/** @brief Event adding a value to the counter.
+ *
+ * Sent by rtt_lite_trace_counter(). It has no time stamp, so the receiving
+ * part uses time of the previous event.
+ *
+ * @param additional Counter id.
+ * @param param      Value added to the counter.
+ */
+#define EV_COUNTER 0x74000000
+
+/** @brief Event reporting current value of the gauge.
+ *
+ * Sent by rtt_lite_trace_gauge(). It has no time stamp, so the receiving
+ * part uses time of the previous event.
+ *
+ * @param additional Gauge id.
+ * @param param      Current value of the gauge.
+ */
+#define EV_GAUGE 0x75000000
+
+/** @brief Event reporting number of events of one class lost by overflow.
+ *
+ * Sent if CONFIG_RTT_LITE_TRACE_DROP_STATS is set for each class that had
+ * events dropped, after EV_OVERFLOW, when RTT buffer has space again.
+ * Sum of all reported counts is equal to the sum of EV_OVERFLOW params.
+ *
+ * @param additional Class, see RTT_LITE_TRACE_CLASS_xyz.
+ * @param param      Number of events of the class dropped since the last
+ *         report.
+ */
+#define EV_OVERFLOW_CLASS 0x76000000
+
 /*
  * Events with 24-bit time stamp and 7-bit ISR number.
  * Bit format:
@@ -275,9 +362,55 @@
 #define EV_ISR_ENTER 0x80000000
 
 
+/*
+ * Compact events send only if CONFIG_RTT_LITE_TRACE_COMPACT_EVENTS is set.
+ * They take 4 bytes instead of 8 and they do not have param part.
+ * Bit format:
+ *     0000 11kk kkdd dddd dddd dddd pppp pppp
+ *     k - compact event kind, see COMPACT_xyz
+ *     d - time stamp delta from the previous event with time stamp
+ *     p - 8-bit parameter
+ */
+
+/** @brief Compact event.
+ *
+ * Each compact event is converted into the full event with absolute time
+ * stamp by the TimeStampCalc.
+ */
+#define EV_COMPACT 0x0C000000
+#define EV_COMPACT_MASK 0xFC000000
+
+#define COMPACT_PADDING 0x00000000
+#define COMPACT_THREAD_STOP 0x00400000
+#define COMPACT_ISR_EXIT 0x00800000
+#define COMPACT_ISR_ENTER 0x00C00000
+#define COMPACT_SYS_CALL 0x01000000
+#define COMPACT_SYS_END_CALL 0x01400000
+
+#define COMPACT_KIND_MASK 0x03C00000
+#define COMPACT_DELTA_MASK 0x003FFF00
+#define COMPACT_DELTA_SHIFT 8
+#define COMPACT_PARAM_MASK 0x000000FF
+
+
 #define SYNC_ADDITIONAL 0x007C7E79
 #define SYNC_PARAM 0x7F7D7A7B
 
+/*
+ * Commands send to the target on RTT down channel with the same index as
+ * the trace channel. Each command takes 8 bytes: 32-bit command id followed
+ * by 32-bit parameter.
+ */
+
+/** @brief Command that sets runtime class mask, see EV_CLASS_MASK.
+ *
+ * @param param      New class mask.
+ */
+#define CMD_SET_CLASS_MASK 0x00000001
+
+#define CMD_SIZE 8
+
+
 #define FORMAT_ARG_END 0
 #define FORMAT_ARG_INT32 1
 #define FORMAT_ARG_INT64 2
@@ -287,13 +420,19 @@
 /* RTT channel name used to identify transfer channel. */
 #define CHANNEL_NAME "NrfLiteTrace"
 
+/* RTT channel name used to transfer printed text, thread and resource
+ * information if CONFIG_RTT_LITE_TRACE_SPLIT_CHANNELS is set. Events from this
+ * channel are merged with the main channel using their time stamps.
+ */
+#define INFO_CHANNEL_NAME "NrfLiteTraceInfo"
+
 
 #define _RTT_LITE_TRACE_EV_MARK_START 0x20000000
 #define _RTT_LITE_TRACE_EV_MARK 0x21000000
 #define _RTT_LITE_TRACE_EV_MARK_STOP 0x22000000
 
 #define _RTT_LITE_TRACE_EV_USER_FIRST 0x23000000
-#define _RTT_LITE_TRACE_EV_USER_LAST 0x77000000
+#define _RTT_LITE_TRACE_EV_USER_LAST 0x6F000000
 
 #define EV_INTERNAL_CORRUPTED 0x79000000
 #define EV_INTERNAL_OVERFLOW 0x7A000000
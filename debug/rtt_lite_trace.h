@@ -18,6 +18,9 @@
 #define RTT_LITE_TRACE_EV_USER_STEP 0x01000000
 #define RTT_LITE_TRACE_EV_USER_LAST 0x6F000000
 
+/* Counter and gauge ids are 24-bit. */
+#define RTT_LITE_TRACE_SERIES_ID_MASK 0x00FFFFFF
+
 #define RTT_LITE_TRACE_USER_EVENT(id) \
 		((id) * RTT_LITE_TRACE_USER_EVENT_STEP \
 		+ RTT_LITE_TRACE_USER_EVENT_FIRST)
@@ -25,6 +28,26 @@
 		((id) * RTT_LITE_TRACE_USER_TIMELESS_EVENT_STEP \
 		+ RTT_LITE_TRACE_USER_TIMELESS_EVENT_FIRST)
 
+/*
+ * Event classes. Scheduling, ISR, system call and user events are written to
+ * the RTT channel CONFIG_RTT_LITE_TRACE_RTT_CHANNEL. Printed text and
+ * information about threads and resources are written to the separate RTT
+ * channel CONFIG_RTT_LITE_TRACE_INFO_RTT_CHANNEL if
+ * CONFIG_RTT_LITE_TRACE_SPLIT_CHANNELS is set. Interrupts are locked while
+ * a record is written to that channel, so printed text, string arguments
+ * and names longer than 64 characters are truncated there.
+ */
+#define RTT_LITE_TRACE_CLASS_SYSTEM 0
+#define RTT_LITE_TRACE_CLASS_SCHED 1
+#define RTT_LITE_TRACE_CLASS_ISR 2
+#define RTT_LITE_TRACE_CLASS_SYSCALL 3
+#define RTT_LITE_TRACE_CLASS_USER 4
+#define RTT_LITE_TRACE_CLASS_PRINT 5
+#define RTT_LITE_TRACE_CLASS_INFO 6
+
+/* Runtime class mask with all classes enabled. */
+#define RTT_LITE_TRACE_CLASS_MASK_ALL 0xFFFFFFFF
+
 #define RTT_LITE_TRACE_LEVEL_LOG 0
 #define RTT_LITE_TRACE_LEVEL_WARN 1
 #define RTT_LITE_TRACE_LEVEL_ERR 2
@@ -61,8 +84,66 @@ struct rtt_lite_trace_format {
 
 u32_t rtt_lite_trace_time(void);
 
+/** @brief Set runtime class mask.
+ *
+ * Events from class n are send only if bit n of the mask is set. Events from
+ * RTT_LITE_TRACE_CLASS_SYSTEM are always send. The mask can also be changed by
+ * the host over RTT down channel. Initial value is taken from
+ * CONFIG_RTT_LITE_TRACE_CLASS_MASK.
+ *
+ * Changing the mask when other context is sending an event with buffer
+ * (e.g. printf) may cut off the buffer.
+ *
+ * @param mask  New class mask.
+ */
+void rtt_lite_trace_class_mask_set(u32_t mask);
+
+/** @brief Get current runtime class mask. */
+u32_t rtt_lite_trace_class_mask_get(void);
+
+/** @brief Set sampling rate of the ISR.
+ *
+ * Only 1 of rate calls of the ISR is traced. Number of all calls is reported
+ * periodically, so the host can scale the sampled data. Available only if
+ * CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING is set.
+ *
+ * @param isr   ISR number.
+ * @param rate  Sampling rate, 1 traces all calls, 0 restores default rate
+ *              CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING_RATE.
+ */
+void rtt_lite_trace_isr_sampling_set(u32_t isr, u32_t rate);
+
 void rtt_lite_trace_event(u32_t event, u32_t param);
 
+/** @brief Send binary payload, e.g. packet header or register dump.
+ *
+ * @param id    Blob id identifying the payload on the host.
+ * @param data  Payload.
+ * @param size  Payload size in bytes.
+ */
+void rtt_lite_trace_blob(u32_t id, const void *data, size_t size);
+
+/** @brief Add a value to the counter.
+ *
+ * Event takes 8 bytes and it has no time stamp. The host sums the values
+ * in time intervals, e.g. to get number of processed packets per second.
+ *
+ * @param id    Counter id, 24-bit.
+ * @param value Value added to the counter.
+ */
+void rtt_lite_trace_counter(u32_t id, u32_t value);
+
+/** @brief Report current value of the gauge.
+ *
+ * Event takes 8 bytes and it has no time stamp. The host calculates
+ * minimum, maximum and average value in time intervals, e.g. of a queue
+ * depth or a heap usage.
+ *
+ * @param id    Gauge id, 24-bit.
+ * @param value Current value.
+ */
+void rtt_lite_trace_gauge(u32_t id, u32_t value);
+
 void rtt_lite_trace_print(u32_t level, const char *text);
 void rtt_lite_trace_printf(struct rtt_lite_trace_format *format, ...);
 
@@ -92,6 +173,12 @@ void sys_trace_thread_name_set(k_tid_t thread);
 #else
 #define sys_trace_thread_name_set(thread)
 #endif
+#if defined(CONFIG_RTT_LITE_TRACE_THREAD_INFO) \
+	|| defined(CONFIG_RTT_LITE_TRACE_STACK_USAGE)
+void sys_trace_thread_abort(k_tid_t thread);
+#else
+#define sys_trace_thread_abort(thread)
+#endif
 #ifdef CONFIG_RTT_LITE_TRACE_SYNCHRO
 void sys_trace_void(u32_t id);
 void sys_trace_end_call(u32_t id);
@@ -100,9 +187,6 @@ void sys_trace_end_call(u32_t id);
 #define sys_trace_end_call(id)
 #endif
 
-/* Trace macros that are ignored */
-#define sys_trace_thread_abort(thread)
-
 /* Trace macros that are actually never called by the Zephyr kernel */
 #define sys_trace_isr_exit_to_scheduler()
 #define sys_trace_thread_info(thread)
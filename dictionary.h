@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _dictionary_h_
+#define _dictionary_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Keeps the newest events that are needed to decode the stream, but they are
+ * sent only once: thread information, formats and resource names. They are
+ * stored as raw events, so they can be put in front of the part of capture
+ * that does not contain them anymore.
+ */
+void dictionary_event(uint32_t event, uint32_t param);
+size_t dictionary_snapshot(uint8_t **data);
+
+#endif
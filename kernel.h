@@ -5,22 +5,121 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Options can be overridden from the compiler command line. */
+#ifndef CONFIG_RTT_LITE_TRACE_FORMAT_ONCE
 #define CONFIG_RTT_LITE_TRACE_FORMAT_ONCE 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_THREAD_INFO
 #define CONFIG_RTT_LITE_TRACE_THREAD_INFO 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_THREAD_INFO_SLOTS
+#define CONFIG_RTT_LITE_TRACE_THREAD_INFO_SLOTS 32
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_THREAD_INFO_REFRESH
+#define CONFIG_RTT_LITE_TRACE_THREAD_INFO_REFRESH 16
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_STACK_USAGE
+#define CONFIG_RTT_LITE_TRACE_STACK_USAGE 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_STACK_USAGE_WORDS
+#define CONFIG_RTT_LITE_TRACE_STACK_USAGE_WORDS 16
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_STACK_USAGE_SLOTS
+#define CONFIG_RTT_LITE_TRACE_STACK_USAGE_SLOTS 32
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_FAST_OVERFLOW_CHECK
 #define CONFIG_RTT_LITE_TRACE_FAST_OVERFLOW_CHECK 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_COMPACT_EVENTS
+#define CONFIG_RTT_LITE_TRACE_COMPACT_EVENTS 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_FLIGHT_RECORDER
+#define CONFIG_RTT_LITE_TRACE_FLIGHT_RECORDER 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_BUFFER_STATS
 #define CONFIG_RTT_LITE_TRACE_BUFFER_STATS 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_TIMER_PRESCALER
+#define CONFIG_RTT_LITE_TRACE_TIMER_PRESCALER 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_TIME_DWT
+#define CONFIG_RTT_LITE_TRACE_TIME_DWT 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_DWT_SHIFT
+#define CONFIG_RTT_LITE_TRACE_DWT_SHIFT 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_KEEPALIVE
+#define CONFIG_RTT_LITE_TRACE_KEEPALIVE 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_KEEPALIVE_IRQ_PRIORITY
+#define CONFIG_RTT_LITE_TRACE_KEEPALIVE_IRQ_PRIORITY 7
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_DROP_STATS
+#define CONFIG_RTT_LITE_TRACE_DROP_STATS 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_IRQ
 #define CONFIG_RTT_LITE_TRACE_IRQ 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING
+#define CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING_RATE
+#define CONFIG_RTT_LITE_TRACE_IRQ_SAMPLING_RATE 16
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_IRQ_COUNT_PERIOD_MS
+#define CONFIG_RTT_LITE_TRACE_IRQ_COUNT_PERIOD_MS 100
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_RTT_CHANNEL
 #define CONFIG_RTT_LITE_TRACE_RTT_CHANNEL 2
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_SPLIT_CHANNELS
+#define CONFIG_RTT_LITE_TRACE_SPLIT_CHANNELS 0
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_INFO_RTT_CHANNEL
+#define CONFIG_RTT_LITE_TRACE_INFO_RTT_CHANNEL 1
+#endif
+#if !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_512B) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_2KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_4KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_8KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_16KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_32KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_64KB)
+#define CONFIG_RTT_LITE_TRACE_INFO_BUFFER_SIZE_1KB 1
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_CLASS_MASK
+#define CONFIG_RTT_LITE_TRACE_CLASS_MASK 0xFFFFFFFF
+#endif
+#ifndef CONFIG_RTT_LITE_TRACE_PRINTF_MAX_ARGS
 #define CONFIG_RTT_LITE_TRACE_PRINTF_MAX_ARGS 10
+#endif
+#if !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_512B) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_2KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_4KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_8KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_16KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_32KB) \
+	&& !defined(CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_64KB)
 #define CONFIG_RTT_LITE_TRACE_BUFFER_SIZE_1KB 1
+#endif
 #define CONFIG_RTT_LITE_TRACE_TIMER0 1
 
 #define CONFIG_THREAD_NAME 1
 #define CONFIG_THREAD_STACK_INFO 1
+#define CONFIG_INIT_STACKS 1
 
 #define IS_ENABLED(x) (x)
 
 #define ALWAYS_INLINE inline
+#define __noinline __attribute__((noinline))
+#define unlikely(x) __builtin_expect(!!(x), 0)
+#define ARG_UNUSED(x) (void)(x)
+
+#define BIT(n) (1UL << (n))
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
 typedef uint8_t u8_t;
 typedef uint16_t u16_t;
@@ -62,9 +161,28 @@ struct _mock_timer
 
 extern struct _mock_timer *NRF_TIMER0;
 
+/* Used if CONFIG_RTT_LITE_TRACE_TIME_DWT is set. */
+struct _mock_dwt
+{
+	uint32_t CTRL;
+	uint32_t CYCCNT;
+};
+
+struct _mock_core_debug
+{
+	uint32_t DEMCR;
+};
+
+extern struct _mock_dwt *DWT;
+extern struct _mock_core_debug *CoreDebug;
+extern uint32_t SystemCoreClock;
+
+#define DWT_CTRL_CYCCNTENA_Msk 0x00000001
+#define CoreDebug_DEMCR_TRCENA_Msk 0x01000000
+
 
 #define irq_lock() (0)
-#define irq_unlock(...)
+#define irq_unlock(key) ARG_UNUSED(key)
 
 
 extern uint8_t _mock_isr_number;
@@ -76,14 +194,19 @@ extern k_tid_t _mock_current_thread;
 #define k_current_get() (_mock_current_thread)
 
 typedef int nrfx_timer_t;
-typedef struct { int frequency; int bit_width; } nrfx_timer_config_t;
+typedef int nrf_timer_frequency_t;
+typedef int nrf_timer_event_t;
+typedef struct { int frequency; int bit_width; int interrupt_priority; } nrfx_timer_config_t;
 #define NRFX_TIMER_DEFAULT_CONFIG {}
 #define nrfx_timer_enable(...)
-#define nrfx_timer_init(...)
+#define nrfx_timer_init(timer, config, handler) ((void)(config), (void)(handler))
+#define nrfx_timer_compare(...)
 #define NRFX_TIMER_INSTANCE(...) (0)
+#define IRQ_CONNECT(...)
 
 #define NRF_TIMER_BIT_WIDTH_24 0
 #define NRF_TIMER_FREQ_16MHz 0
+#define NRF_TIMER_CC_CHANNEL1 1
 
 #define k_thread_name_get(x) ((x)->name)
 
@@ -33,6 +33,12 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <memory>
+#include <algorithm>
+#include <set>
+
+#include <sys/stat.h>
+#include <zlib.h>
 
 #include "options.h"
 #include "logs.h"
@@ -48,6 +54,9 @@
 
 #define FATAL(text, ...) do { fprintf(stderr, "FATAL ERROR!!!\n" text "\n", ##__VA_ARGS__); exit(1); } while (0)
 
+// Unit of time stamps returned by TimeStampCalc. Time stamps with other frequency are converted.
+#define TIMER_FREQUENCY 16000000
+
 
 int parse_header(const char *str, int len)
 {
@@ -69,7 +78,118 @@ int parse_header(const char *str, int len)
 	return str - start;
 }
 
+/*
+ * Self-instrumentation of the decoding stages. Decoder is single threaded, so counters are plain
+ * variables updated by each stage. They are periodically written to the stats file with their
+ * rates during the last interval, so progress of a long decoding can be watched.
+ */
+class PipelineStats
+{
+public:
+	enum Counter {
+		LOG_READER_BYTES,
+		LOG_READER_EVENTS,
+		LOG_READER_RESYNCS,
+		OVERFLOW_DETECTION_EVENTS,
+		OVERFLOW_DETECTION_OVERFLOW_EVENTS,
+		OVERFLOW_DETECTION_DETECTED,
+		OVERFLOW_DETECTION_DROPPED,
+		TIME_STAMP_CALC_EVENTS,
+		BUFFER_COMBINE_EVENTS,
+		COUNTERS,
+	};
+	PipelineStats();
+	void add(Counter counter, uint64_t value = 1) { values[counter] += value; }
+	void setFile(const std::string &name) { fileName = name; }
+	void poll();
+	void publish();
+private:
+	// Time is checked after this number of polls, so polling costs almost nothing.
+	static const uint32_t POLLS_PER_CHECK = 4096;
+	static const uint64_t PUBLISH_INTERVAL_NS = 1000000000uLL;
+	static const char *names[COUNTERS];
+	static const bool rates[COUNTERS];
+	uint64_t values[COUNTERS];
+	uint64_t lastValues[COUNTERS];
+	std::string fileName;
+	uint32_t polls;
+	uint64_t startTime;
+	uint64_t publishTime;
+
+	static uint64_t now();
+};
+
+const char *PipelineStats::names[COUNTERS] = {
+	"LogReader.bytes",
+	"LogReader.events",
+	"LogReader.resyncs",
+	"OverflowDetection.events",
+	"OverflowDetection.overflow_events",
+	"OverflowDetection.detected_overflows",
+	"OverflowDetection.dropped_events",
+	"TimeStampCalc.events",
+	"BufferCombine.events",
+};
+
+const bool PipelineStats::rates[COUNTERS] = { true, true, false, true, false, false, false, true, true };
+
+PipelineStats pipelineStats;
+
+PipelineStats::PipelineStats() : polls(0)
+{
+	memset(values, 0, sizeof(values));
+	memset(lastValues, 0, sizeof(lastValues));
+	startTime = now();
+	publishTime = startTime;
+}
+
+uint64_t PipelineStats::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void PipelineStats::poll()
+{
+	if (fileName.empty() || ++polls < POLLS_PER_CHECK) {
+		return;
+	}
+	polls = 0;
+	if (now() - publishTime >= PUBLISH_INTERVAL_NS) {
+		publish();
+	}
+}
+
+void PipelineStats::publish()
+{
+	uint64_t time = now();
+	double interval = (double)(time - publishTime) / 1e9;
+
+	if (fileName.empty()) {
+		return;
+	}
+
+	// Stats file is replaced at once, so readers never see partial content.
+	std::string tmp = fileName + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "w");
+	if (f == NULL) {
+		FATAL("Cannot write stats file '%s'!", tmp.c_str());
+	}
+	fprintf(f, "# Decoder stats, %.3f s since start\n", (double)(time - startTime) / 1e9);
+	for (int i = 0; i < COUNTERS; i++) {
+		fprintf(f, "%s %llu\n", names[i], (unsigned long long)values[i]);
+		if (rates[i]) {
+			fprintf(f, "%s_per_s %.0f\n", names[i], interval > 0.0 ? (double)(values[i] - lastValues[i]) / interval : 0.0);
+		}
+		lastValues[i] = values[i];
+	}
+	if (fclose(f) != 0 || rename(tmp.c_str(), fileName.c_str()) < 0) {
+		FATAL("Cannot write stats file '%s'!", fileName.c_str());
+	}
 
+	publishTime = time;
+}
 
 class LogReader
 {
@@ -95,7 +215,8 @@ private:
 	void readFooter();
 	static int parseHeader(const char *str);
 	static int parseFooter(const char *str, size_t len);
-	int synchronize();
+	bool parseEvent(uint32_t &event, uint32_t &param);
+	int synchronize(int consumed);
 	int read(void* buffer, int length);
 	int seek(int offset);
 };
@@ -109,6 +230,7 @@ int LogReader::read(void* buffer, int length)
 	int res = fread(buffer, 1, read_end - data_pos, f);
 	if (res >= 0) {
 		data_pos += res;
+		pipelineStats.add(PipelineStats::LOG_READER_BYTES, res);
 	}
 	return res;
 }
@@ -256,16 +378,56 @@ uint32_t generateCorrupted(uint32_t &param, const auto& callback) {
 }
 
 bool LogReader::readEvent(uint32_t &event, uint32_t &param)
+{
+	if (!parseEvent(event, param))
+		return false;
+
+	pipelineStats.add(PipelineStats::LOG_READER_EVENTS);
+	return true;
+}
+
+bool LogReader::parseEvent(uint32_t &event, uint32_t &param)
 {
 	int len;
 	uint32_t buf[2];
 	uint32_t id;
 
 	do {
-		len = read(buf, sizeof(buf));
+		len = read(&buf[0], sizeof(buf[0]));
+		if (len < 0) {
+			FATAL("Input file read error!");
+		} else if (len < sizeof(buf[0])) {
+			return false;
+		}
+
+		if ((buf[0] & EV_COMPACT_MASK) == EV_COMPACT) {
+			switch (buf[0] & COMPACT_KIND_MASK)
+			{
+			case COMPACT_PADDING:
+				continue;
+			case COMPACT_THREAD_STOP:
+			case COMPACT_ISR_EXIT:
+			case COMPACT_ISR_ENTER:
+			case COMPACT_SYS_CALL:
+			case COMPACT_SYS_END_CALL:
+				event = buf[0];
+				param = 0;
+				return true;
+			default:
+				// corrupted data - synchronize the stream
+				break;
+			}
+			len = synchronize(sizeof(buf[0]));
+			event = generateCorrupted(param, [len](auto x) {
+				return sprintf(x, "Corrupted data. Synchronized after %d bytes.", len);
+			});
+			return true;
+		}
+
+		len = read(&buf[1], sizeof(buf[1]));
 		if (len < 0) {
 			FATAL("Input file read error!");
-		} else if (len < sizeof(buf)) {
+		} else if (len < sizeof(buf[1])) {
 			return false;
 		}
 
@@ -293,6 +455,14 @@ bool LogReader::readEvent(uint32_t &event, uint32_t &param)
 		case EV_BUFFER_END:
 		case EV_BUFFER_BEGIN_END:
 		case EV_RES_NAME:
+		case EV_CLASS_MASK:
+		case EV_BLOB:
+		case EV_KEEPALIVE:
+		case EV_ISR_COUNT:
+		case EV_STACK_USAGE:
+		case EV_COUNTER:
+		case EV_GAUGE:
+		case EV_OVERFLOW_CLASS:
 		case EV_SYSTEM_RESET:
 		case EV_OVERFLOW:
 		case EV_IDLE:
@@ -322,7 +492,7 @@ bool LogReader::readEvent(uint32_t &event, uint32_t &param)
 			break; // invalid sync - synchronize the stream
 		}
 
-		len = synchronize();
+		len = synchronize(sizeof(buf));
 
 		event = generateCorrupted(param, [len](auto x) {
 			return sprintf(x, "Corrupted data. Synchronized after %d bytes.", len);
@@ -333,19 +503,20 @@ bool LogReader::readEvent(uint32_t &event, uint32_t &param)
 }
 
 
-int LogReader::synchronize()
+int LogReader::synchronize(int consumed)
 {
 	uint8_t buffer[1024];
 	int res;
 	int len;
 	int total = 0;
 	
-	res = seek(-7);
+	res = seek(1 - consumed);
 	if (res < 0) {
 		FATAL("Input file read error %d!", res);
 	}
 
 	fprintf(stderr, "Stream corrupted. Synchronizing...\n");
+	pipelineStats.add(PipelineStats::LOG_READER_RESYNCS);
 
 	len = 0;
 	do {
@@ -426,6 +597,7 @@ bool OverflowDetection::readEvent(uint32_t &event, uint32_t &param)
 	event = queue.front().event;
 	param = queue.front().param;
 	queue.pop_front();
+	pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_EVENTS);
 	if (counterValid) {
 		if (lastCounterUpdate == 0) {
 			counterValid = false;
@@ -469,6 +641,10 @@ void OverflowDetection::fillQueue()
 			counterValid = true;
 			checkCounter(1, 0);
 			break;
+
+		case EV_OVERFLOW:
+			pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_OVERFLOW_EVENTS);
+			break;
 		
 		default:
 			break;
@@ -485,16 +661,22 @@ void OverflowDetection::checkCounter(uint32_t currentCounter, uint32_t inc)
 	if (!counterValid) {
 		if (currentCounter > 1) {
 			fprintf(stderr, "Overflow detected before reset. Dropping %d events.\n", (int)queue.size());
+			pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DETECTED);
+			pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DROPPED, queue.size());
 			queue.clear();
 			queue.push_back(Event(EV_SYSTEM_RESET, 0));
 			queue.push_back(Event(EV_OVERFLOW, 0));
 		}
 	} else if (diff > 0) {
 		fprintf(stderr, "Overflow detected. Dropping %d events.\n", (int)(queue.size() - lastCounterUpdate));
+		pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DETECTED);
+		pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DROPPED, queue.size() - lastCounterUpdate);
 		queue.erase(queue.begin() + lastCounterUpdate + 1, queue.end());
 		queue.push_back(Event(EV_INTERNAL_OVERFLOW, 0));
 	} else if (diff < 0) {
 		fprintf(stderr, "Overflow detected and reset in it. Dropping %d events.\n", (int)(queue.size() - lastCounterUpdate));
+		pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DETECTED);
+		pipelineStats.add(PipelineStats::OVERFLOW_DETECTION_DROPPED, queue.size() - lastCounterUpdate);
 		queue.erase(queue.begin() + lastCounterUpdate + 1, queue.end());
 		queue.push_back(Event(EV_SYSTEM_RESET, 0));
 		queue.push_back(Event(EV_OVERFLOW, 0));
@@ -508,17 +690,98 @@ void OverflowDetection::checkCounter(uint32_t currentCounter, uint32_t inc)
 class TimeStampCalc
 {
 public:
-	TimeStampCalc(const std::string &file_name) : reader(file_name), currentTime(0), resetTime(0) {}
+	TimeStampCalc(const std::string &file_name) : reader(file_name), currentTime(0), resetTime(0), session(0), deltaBaseValid(false),
+		frequency(TIMER_FREQUENCY) {
+		readHeaderFrequency();
+	}
 	bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param);
 	std::vector<std::string>& getHeaders() {
 		return reader.getHeaders();
 	}
+	uint32_t getSession() {
+		return session;
+	}
+	uint64_t getSessionTime() {
+		return toTimerFrequency(currentTime);
+	}
 private:
 	OverflowDetection reader;
+	// Time since the reset in ticks of the target timer.
 	uint64_t currentTime;
 	uint64_t resetTime;
+	uint32_t session;
+	bool deltaBaseValid;
+	// Frequency of the target timer reported by EV_SYSTEM_RESET.
+	uint32_t frequency;
+
+	void expandCompact(uint32_t &event, uint32_t &param);
+	uint64_t toTimerFrequency(uint64_t ticks);
+	void readHeaderFrequency();
 };
 
+// Capture segments and exports usually do not begin with EV_SYSTEM_RESET, so the frequency is in the header.
+void TimeStampCalc::readHeaderFrequency()
+{
+	static const std::string prefix = "# Time stamp frequency: ";
+	uint32_t value;
+
+	for (auto& header : reader.getHeaders()) {
+		if (header.compare(0, prefix.size(), prefix) == 0) {
+			value = strtoul(header.c_str() + prefix.size(), NULL, 10);
+			if (value != 0) {
+				frequency = value;
+			}
+		}
+	}
+}
+
+uint64_t TimeStampCalc::toTimerFrequency(uint64_t ticks)
+{
+	if (frequency == TIMER_FREQUENCY) {
+		return ticks;
+	}
+	return ticks / frequency * TIMER_FREQUENCY + ticks % frequency * TIMER_FREQUENCY / frequency;
+}
+
+void TimeStampCalc::expandCompact(uint32_t &event, uint32_t &param)
+{
+	uint32_t delta = (event & COMPACT_DELTA_MASK) >> COMPACT_DELTA_SHIFT;
+	uint32_t compactParam = event & COMPACT_PARAM_MASK;
+
+	if (!deltaBaseValid) {
+		// Time of the previous event was lost, so this is the best guess.
+		fprintf(stderr, "Compact event without time stamp base.\n");
+		deltaBaseValid = true;
+	}
+
+	currentTime += delta;
+	param = 0;
+
+	switch (event & COMPACT_KIND_MASK)
+	{
+	case COMPACT_THREAD_STOP:
+		event = EV_THREAD_STOP;
+		break;
+	case COMPACT_ISR_EXIT:
+		event = EV_ISR_EXIT;
+		break;
+	case COMPACT_ISR_ENTER:
+		event = EV_ISR_ENTER | ((compactParam & 0x7F) << 24);
+		break;
+	case COMPACT_SYS_CALL:
+		event = EV_SYS_CALL;
+		param = compactParam;
+		break;
+	case COMPACT_SYS_END_CALL:
+	default:
+		event = EV_SYS_END_CALL;
+		param = compactParam;
+		break;
+	}
+
+	event |= (uint32_t)currentTime & 0x00FFFFFF;
+}
+
 bool TimeStampCalc::readEvent(uint64_t &time, uint32_t &event, uint32_t &param)
 {
 	uint32_t id;
@@ -527,15 +790,32 @@ bool TimeStampCalc::readEvent(uint64_t &time, uint32_t &event, uint32_t &param)
 	if (!reader.readEvent(event, param))
 		return false;
 
+	pipelineStats.add(PipelineStats::TIME_STAMP_CALC_EVENTS);
+
+	if ((event & EV_COMPACT_MASK) == EV_COMPACT) {
+		expandCompact(event, param);
+		time = resetTime + toTimerFrequency(currentTime);
+		return true;
+	}
+
 	id = event & 0xFF000000;
 
+	if (id == EV_OVERFLOW || id == EV_INTERNAL_OVERFLOW || id == EV_INTERNAL_CORRUPTED) {
+		deltaBaseValid = false;
+	}
+
 	if (id == EV_SYSTEM_RESET) {
-		resetTime = resetTime + currentTime + 1;
+		resetTime = resetTime + toTimerFrequency(currentTime) + 1;
 		currentTime = 0;
+		session++;
+		// Zero is send by older versions and by reset inserted on overflow.
+		if (param != 0) {
+			frequency = param;
+		}
 		hasTimeStamp = true;
 	} else if (id <= 0x0F000000uL) {
 		hasTimeStamp = false;
-	} else if (id <= 0x77000000uL) {
+	} else if (id <= 0x71000000uL) {
 		hasTimeStamp = true;
 	} else if (id <= 0x7F000000uL) {
 		hasTimeStamp = false;
@@ -551,9 +831,97 @@ bool TimeStampCalc::readEvent(uint64_t &time, uint32_t &event, uint32_t &param)
 		}
 		currentTime &= ~(uint64_t)0x00FFFFFF;
 		currentTime |= (uint64_t)now;
+		deltaBaseValid = true;
 	}
 
-	time = resetTime + currentTime;
+	time = resetTime + toTimerFrequency(currentTime);
+
+	return true;
+}
+
+/*
+ * Source of events for BufferCombine. Time is in TIMER_FREQUENCY ticks and channel is
+ * index of the RTT channel that the event came from.
+ */
+class EventSource
+{
+public:
+	virtual ~EventSource() {}
+	virtual bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param, uint32_t &channel) = 0;
+	virtual std::vector<std::string>& getHeaders() = 0;
+};
+
+class ChannelMerge : public EventSource
+{
+public:
+	ChannelMerge(const std::vector<std::string> &file_names);
+	bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param, uint32_t &channel);
+	std::vector<std::string>& getHeaders() {
+		return channels[0]->reader.getHeaders();
+	}
+private:
+	struct Channel {
+		TimeStampCalc reader;
+		bool pending;
+		bool done;
+		uint32_t session;
+		uint64_t sessionTime;
+		uint32_t event;
+		uint32_t param;
+		Channel(const std::string &file_name) : reader(file_name), pending(false), done(false) {}
+	};
+	std::vector<std::unique_ptr<Channel>> channels;
+	uint32_t session;
+	uint64_t resetTime;
+	uint64_t lastSessionTime;
+};
+
+ChannelMerge::ChannelMerge(const std::vector<std::string> &file_names) : session(0), resetTime(0), lastSessionTime(0)
+{
+	for (auto& name : file_names) {
+		channels.emplace_back(new Channel(name));
+	}
+}
+
+bool ChannelMerge::readEvent(uint64_t &time, uint32_t &event, uint32_t &param, uint32_t &channel)
+{
+	Channel *next = NULL;
+	uint64_t channelTime;
+
+	for (size_t i = 0; i < channels.size(); i++) {
+		Channel *c = channels[i].get();
+		if (!c->pending && !c->done) {
+			if (c->reader.readEvent(channelTime, c->event, c->param)) {
+				c->pending = true;
+				c->session = c->reader.getSession();
+				c->sessionTime = c->reader.getSessionTime();
+			} else {
+				c->done = true;
+			}
+		}
+		if (!c->pending) {
+			continue;
+		}
+		// Time stamps are comparable only within the same session, i.e. between two resets.
+		if (next == NULL || c->session < next->session || (c->session == next->session && c->sessionTime < next->sessionTime)) {
+			next = c;
+			channel = i;
+		}
+	}
+
+	if (next == NULL)
+		return false;
+
+	if (next->session != session) {
+		resetTime = resetTime + lastSessionTime + 1;
+		session = next->session;
+	}
+	lastSessionTime = next->sessionTime;
+
+	time = resetTime + next->sessionTime;
+	event = next->event;
+	param = next->param;
+	next->pending = false;
 
 	return true;
 }
@@ -561,12 +929,15 @@ bool TimeStampCalc::readEvent(uint64_t &time, uint32_t &event, uint32_t &param)
 class BufferCombine
 {
 public:
-	BufferCombine(const std::string &file_name) : reader(file_name), currentThread((uint64_t)2 << 32), currentContext((uint64_t)2 << 32) {}
+	BufferCombine(const std::string &file_name) : reader(new ChannelMerge(std::vector<std::string>(1, file_name))), currentThread((uint64_t)2 << 32), currentContext((uint64_t)2 << 32) {}
+	BufferCombine(const std::vector<std::string> &file_names) : reader(new ChannelMerge(file_names)), currentThread((uint64_t)2 << 32), currentContext((uint64_t)2 << 32) {}
+	BufferCombine(EventSource *source) : reader(source), currentThread((uint64_t)2 << 32), currentContext((uint64_t)2 << 32) {}
 	bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer);
 	std::vector<std::string>& getHeaders() {
-		return reader.getHeaders();
+		return reader->getHeaders();
 	}
 private:
+	bool combineEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer);
 	enum BufferState {
 		BUFFER_EMPTY,
 		BUFFER_RUNNING,
@@ -583,9 +954,14 @@ private:
 		BufferState bufferState;
 		std::basic_string<uint8_t> threadInfo;
 		BufferState threadInfoState;
-		Context() : bufferState(BUFFER_EMPTY), threadInfoState(BUFFER_EMPTY) {};
+		// Event waiting for its buffer.
+		bool pending;
+		uint64_t pendingTime;
+		uint32_t pendingEvent;
+		uint32_t pendingParam;
+		Context() : bufferState(BUFFER_EMPTY), threadInfoState(BUFFER_EMPTY), pending(false) {};
 	};
-	TimeStampCalc reader;
+	std::unique_ptr<EventSource> reader;
 	std::map<uint64_t, Context> ctx;
 	uint64_t currentThread;
 	uint64_t currentContext;
@@ -593,12 +969,23 @@ private:
 };
 
 bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer)
+{
+	if (!combineEvent(time, event, param, buffer))
+		return false;
+
+	pipelineStats.add(PipelineStats::BUFFER_COMBINE_EVENTS);
+	pipelineStats.poll();
+	return true;
+}
+
+bool BufferCombine::combineEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer)
 {
 	uint32_t id;
-	bool bufferExpected;
+	uint32_t channel;
+	uint64_t bufferContext;
 
 	do {
-		if (!reader.readEvent(time, event, param))
+		if (!reader->readEvent(time, event, param, channel))
 			return false;
 
 		id = event & 0xFF000000;
@@ -606,14 +993,34 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 			id = 0x80000000;
 		}
 
-		if (id == EV_FORMAT || id == EV_PRINTF || id == EV_PRINT  || id == EV_RES_NAME) {
+		// Buffers on the additional channels are never interrupted by other buffers,
+		// so each channel has just one context.
+		if (channel == 0) {
+			bufferContext = currentContext;
+		} else {
+			bufferContext = ((uint64_t)3 << 32) | channel;
+			if (id == EV_SYSTEM_RESET || id == EV_OVERFLOW || id == EV_INTERNAL_OVERFLOW || id == EV_INTERNAL_CORRUPTED) {
+				ctx.erase(bufferContext);
+				return true;
+			}
+		}
 
-			auto& c = ctx[param];
-			if (c.threadInfoState != BUFFER_DONE) {
+		if (id == EV_FORMAT || id == EV_PRINTF || id == EV_RES_NAME || id == EV_BLOB
+			|| (id == EV_PRINT && (param & 0xFF) && (param & 0xFF00) && (param & 0xFF0000) && (param & 0xFF000000))) {
+
+			// These events are followed by a buffer from the same context, so they are returned
+			// when the buffer is complete. EV_PRINT has buffer only if the text does not fit into param.
+			auto& c = ctx[bufferContext];
+			if (c.pending) {
 				// TODO: Report error
 			}
-			std::swap(c.buffer, buffer);
-			c.buffer.clear();
+			c.pending = true;
+			c.pendingTime = time;
+			c.pendingEvent = event;
+			c.pendingParam = param;
+
+		} else if (id == EV_PRINT || id == EV_KEEPALIVE) {
+
 			return true;
 
 		} else if (id >= _RTT_LITE_TRACE_EV_USER_FIRST && id <= _RTT_LITE_TRACE_EV_USER_LAST) {
@@ -637,7 +1044,13 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 
 		} else if (id == EV_SYSTEM_RESET || id == EV_OVERFLOW || id == EV_INTERNAL_OVERFLOW || id == EV_INTERNAL_CORRUPTED) {
 
-			ctx.clear();
+			for (auto it = ctx.begin(); it != ctx.end(); ) {
+				if ((it->first >> 32) == 3) {
+					it++;
+				} else {
+					it = ctx.erase(it);
+				}
+			}
 			isrStack.clear();
 			currentThread = (uint64_t)2 << 32;
 			currentContext = (uint64_t)2 << 32;
@@ -697,7 +1110,7 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 
 		} else if (id == EV_BUFFER_BEGIN) {
 
-			auto& c = ctx[currentContext];
+			auto& c = ctx[bufferContext];
 			if (c.bufferState != BUFFER_EMPTY) {
 				// TODO: Report warning
 			}
@@ -708,7 +1121,7 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 
 		} else if (id == EV_BUFFER_NEXT) {
 
-			auto& c = ctx[currentContext];
+			auto& c = ctx[bufferContext];
 			if (c.bufferState != BUFFER_RUNNING) {
 				// TODO: Report error
 				event = EV_INTERNAL_CORRUPTED;
@@ -719,7 +1132,7 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 
 		} else if (id == EV_BUFFER_END) {
 
-			auto& c = ctx[currentContext];
+			auto& c = ctx[bufferContext];
 			if (c.bufferState != BUFFER_RUNNING) {
 				// TODO: Report error
 				event = EV_INTERNAL_CORRUPTED;
@@ -732,10 +1145,20 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 				c.buffer.resize(c.buffer.length() - 6 + lastChunk);
 			}
 			c.bufferState = BUFFER_DONE;
+			if (c.pending) {
+				time = c.pendingTime;
+				event = c.pendingEvent;
+				param = c.pendingParam;
+				std::swap(c.buffer, buffer);
+				c.buffer.clear();
+				c.bufferState = BUFFER_EMPTY;
+				c.pending = false;
+				return true;
+			}
 
 		} else if (id == EV_BUFFER_BEGIN_END) {
 
-			auto& c = ctx[currentContext];
+			auto& c = ctx[bufferContext];
 			if (c.bufferState != BUFFER_EMPTY) {
 				// TODO: Report warning
 			}
@@ -747,6 +1170,16 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 				c.buffer.resize(c.buffer.length() - 6 + lastChunk);
 			}
 			c.bufferState = BUFFER_DONE;
+			if (c.pending) {
+				time = c.pendingTime;
+				event = c.pendingEvent;
+				param = c.pendingParam;
+				std::swap(c.buffer, buffer);
+				c.buffer.clear();
+				c.bufferState = BUFFER_EMPTY;
+				c.pending = false;
+				return true;
+			}
 
 		} else {
 
@@ -757,21 +1190,1006 @@ bool BufferCombine::readEvent(uint64_t &time, uint32_t &event, uint32_t &param,
 	} while (true);
 }
 
-int main()
+/*
+ * Reads events of one board from merged multi-board capture. The file starts with
+ * header lines followed by records: u64 host time in nanoseconds since the capture
+ * start, u32 board, u32 event and u32 param, little endian. Compact events are
+ * already expanded by the capture, so there is one channel only.
+ */
+class BoardRecordReader : public EventSource
+{
+public:
+	BoardRecordReader(const std::string &file_name, uint32_t board);
+	~BoardRecordReader();
+	bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param, uint32_t &channel);
+	std::vector<std::string>& getHeaders() {
+		return headers;
+	}
+	static bool readHeaders(FILE *f, std::vector<std::string> &headers);
+private:
+	static const size_t RECORD_SIZE = 20;
+	FILE *f;
+	uint32_t board;
+	std::vector<std::string> headers;
+};
+
+BoardRecordReader::BoardRecordReader(const std::string &file_name, uint32_t board) : board(board)
+{
+	f = fopen(file_name.c_str(), "rb");
+	if (f == NULL) {
+		FATAL("Cannot open file \"%s\"!", file_name.c_str());
+	}
+	readHeaders(f, headers);
+}
+
+BoardRecordReader::~BoardRecordReader()
+{
+	fclose(f);
+}
+
+bool BoardRecordReader::readHeaders(FILE *f, std::vector<std::string> &headers)
+{
+	char line[256];
+	long pos = ftell(f);
+	int c;
+
+	while ((c = fgetc(f)) == '#') {
+		ungetc(c, f);
+		if (fgets(line, sizeof(line), f) == NULL)
+			break;
+		std::string header(line);
+		while (header.size() > 0 && (header.back() == '\n' || header.back() == '\r')) {
+			header.pop_back();
+		}
+		headers.push_back(header);
+		pos = ftell(f);
+	}
+	fseek(f, pos, SEEK_SET);
+
+	return headers.size() > 0 && headers[0].compare(0, 30, "# NrfLiteTrace merged capture ") == 0;
+}
+
+bool BoardRecordReader::readEvent(uint64_t &time, uint32_t &event, uint32_t &param, uint32_t &channel)
+{
+	uint8_t data[RECORD_SIZE];
+	uint64_t ns;
+	uint32_t recordBoard;
+
+	do {
+		if (fread(data, 1, sizeof(data), f) != sizeof(data))
+			return false;
+		memcpy(&recordBoard, &data[8], 4);
+	} while (recordBoard != board);
+
+	memcpy(&ns, &data[0], 8);
+	memcpy(&event, &data[12], 4);
+	memcpy(&param, &data[16], 4);
+	time = ns / 1000000000 * TIMER_FREQUENCY + ns % 1000000000 * TIMER_FREQUENCY / 1000000000;
+	channel = 0;
+
+	return true;
+}
+
+/*
+ * Reads a capture of a single board or a merged capture of multiple boards. Buffers of
+ * each board are combined separately and events of all boards are returned in time order.
+ */
+class BoardMerge
+{
+public:
+	BoardMerge(const std::vector<std::string> &file_names);
+	bool readEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer, uint32_t &board);
+	uint32_t getBoardCount() {
+		return boards.size();
+	}
+	bool isMerged() {
+		return merged;
+	}
+private:
+	struct Board {
+		std::unique_ptr<BufferCombine> reader;
+		bool pending;
+		bool done;
+		uint64_t time;
+		uint32_t event;
+		uint32_t param;
+		std::basic_string<uint8_t> buffer;
+		Board(BufferCombine *reader) : reader(reader), pending(false), done(false) {}
+	};
+	std::vector<std::unique_ptr<Board>> boards;
+	bool merged;
+};
+
+BoardMerge::BoardMerge(const std::vector<std::string> &file_names) : merged(false)
+{
+	std::vector<std::string> headers;
+
+	if (file_names.size() == 1) {
+		FILE *f = fopen(file_names[0].c_str(), "rb");
+		if (f != NULL) {
+			merged = BoardRecordReader::readHeaders(f, headers);
+			fclose(f);
+		}
+	}
+
+	if (!merged) {
+		boards.emplace_back(new Board(new BufferCombine(file_names)));
+		return;
+	}
+
+	for (auto& header : headers) {
+		if (header.compare(0, 8, "# Board ") == 0) {
+			uint32_t board = boards.size();
+			boards.emplace_back(new Board(new BufferCombine(new BoardRecordReader(file_names[0], board))));
+		}
+	}
+	if (boards.size() == 0) {
+		FATAL("No boards in merged capture \"%s\"!", file_names[0].c_str());
+	}
+}
+
+bool BoardMerge::readEvent(uint64_t &time, uint32_t &event, uint32_t &param, std::basic_string<uint8_t> &buffer, uint32_t &board)
 {
-	BufferCombine reader("./test.log");
+	Board *next = NULL;
+
+	for (size_t i = 0; i < boards.size(); i++) {
+		Board *b = boards[i].get();
+		if (!b->pending && !b->done) {
+			if (b->reader->readEvent(b->time, b->event, b->param, b->buffer)) {
+				b->pending = true;
+			} else {
+				b->done = true;
+			}
+		}
+		if (b->pending && (next == NULL || b->time < next->time)) {
+			next = b;
+			board = i;
+		}
+	}
+
+	if (next == NULL)
+		return false;
+
+	time = next->time;
+	event = next->event;
+	param = next->param;
+	std::swap(next->buffer, buffer);
+	next->buffer.clear();
+	next->pending = false;
+
+	return true;
+}
+
+/*
+ * Collects ISR statistics: number of calls, histogram of durations and CPU load. If ISR sampling
+ * is enabled on the target, only part of the calls are traced, so the results are scaled using
+ * number of calls reported by EV_ISR_COUNT or using sampling rate if there is no report yet.
+ * Time of nested calls that were not traced is counted to the interrupted ISR.
+ */
+class IsrStats
+{
+public:
+	IsrStats() : firstTime(0), lastTime(0), timeValid(false) {}
+	void process(uint64_t time, uint32_t event, uint32_t param);
+	void print(FILE* f);
+private:
+	static const int HISTOGRAM_SIZE = 24;
+	struct Isr {
+		uint64_t traced;
+		uint64_t reported;
+		uint32_t rate;
+		uint64_t busyTime;
+		uint64_t minTime;
+		uint64_t maxTime;
+		uint64_t histogram[HISTOGRAM_SIZE];
+		Isr() : traced(0), reported(0), rate(1), busyTime(0), minTime(UINT64_MAX), maxTime(0), histogram() {}
+	};
+	struct Running {
+		uint32_t isr;
+		uint64_t enterTime;
+		uint64_t nestedTime;
+	};
+	std::map<uint32_t, Isr> isrs;
+	std::vector<Running> stack;
+	uint64_t firstTime;
+	uint64_t lastTime;
+	bool timeValid;
+};
+
+void IsrStats::process(uint64_t time, uint32_t event, uint32_t param)
+{
+	uint32_t id = event & 0xFF000000;
+
+	if (!timeValid) {
+		firstTime = time;
+		timeValid = true;
+	}
+	lastTime = time;
+
+	if (id & 0x80000000) {
+		stack.push_back({ (event >> 24) & 0x7F, time, 0 });
+	} else if (id == EV_ISR_EXIT) {
+		if (stack.size() == 0) {
+			return;
+		}
+		Running r = stack.back();
+		stack.pop_back();
+		uint64_t duration = time - r.enterTime;
+		auto& isr = isrs[r.isr];
+		int bucket = 0;
+		while ((duration >> bucket) > 1 && bucket < HISTOGRAM_SIZE - 1) {
+			bucket++;
+		}
+		isr.traced++;
+		isr.busyTime += duration - r.nestedTime;
+		isr.minTime = std::min(isr.minTime, duration);
+		isr.maxTime = std::max(isr.maxTime, duration);
+		isr.histogram[bucket]++;
+		if (stack.size() > 0) {
+			stack.back().nestedTime += duration;
+		}
+	} else if (id == EV_ISR_COUNT) {
+		auto& isr = isrs[event & 0x7F];
+		isr.reported += param;
+		isr.rate = (event >> 8) & 0xFFFF;
+	} else if (id == EV_SYSTEM_RESET || id == EV_OVERFLOW || id == EV_INTERNAL_OVERFLOW || id == EV_INTERNAL_CORRUPTED) {
+		stack.clear();
+	}
+}
+
+void IsrStats::print(FILE* f)
+{
+	double totalTime = (double)(lastTime - firstTime);
+
+	fprintf(f, "ISR    calls(est)  traced  rate    min[us]    avg[us]    max[us]   load[%%]\n");
+	for (auto& it : isrs) {
+		auto& isr = it.second;
+		if (isr.traced == 0) {
+			fprintf(f, "%3d  %12llu  %6d  %4d          -          -          -         -\n",
+				it.first, (unsigned long long)isr.reported, 0, isr.rate);
+			continue;
+		}
+		double scale = (isr.reported > 0) ? (double)isr.reported / (double)isr.traced : (double)isr.rate;
+		fprintf(f, "%3d  %12.0f  %6llu  %4d  %9.2f  %9.2f  %9.2f  %8.3f\n",
+			it.first, (double)isr.traced * scale, (unsigned long long)isr.traced, isr.rate,
+			(double)isr.minTime * 1000000.0 / TIMER_FREQUENCY,
+			(double)isr.busyTime * 1000000.0 / TIMER_FREQUENCY / (double)isr.traced,
+			(double)isr.maxTime * 1000000.0 / TIMER_FREQUENCY,
+			totalTime > 0 ? (double)isr.busyTime * scale * 100.0 / totalTime : 0.0);
+		for (int i = 0; i < HISTOGRAM_SIZE; i++) {
+			if (isr.histogram[i] > 0) {
+				fprintf(f, "       <%10.2f us  %12.0f\n", (double)((uint64_t)2 << i) * 1000000.0 / TIMER_FREQUENCY,
+					(double)isr.histogram[i] * scale);
+			}
+		}
+	}
+}
+
+/*
+ * Collects peak stack usage of each thread reported by EV_STACK_USAGE. Names and stack sizes are
+ * taken from the thread information. Each new peak is kept with its time, so the growth of stack
+ * usage over time can be printed.
+ */
+class StackStats
+{
+public:
+	void process(uint64_t time, uint32_t event, uint32_t param, const std::basic_string<uint8_t> &buffer);
+	void print(FILE* f);
+private:
+	struct Peak {
+		uint64_t time;
+		uint32_t used;
+	};
+	struct Thread {
+		std::string name;
+		uint32_t size;
+		std::vector<Peak> peaks;
+		Thread() : size(0) {}
+	};
+	std::map<uint32_t, Thread> threads;
+};
+
+void StackStats::process(uint64_t time, uint32_t event, uint32_t param, const std::basic_string<uint8_t> &buffer)
+{
+	uint32_t id = event & 0xFF000000;
+
+	if (id == EV_THREAD_INFO_END && buffer.size() >= 8) {
+		auto& thread = threads[param];
+		thread.size = buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16);
+		thread.name.assign((const char *)&buffer[8], buffer.size() - 8);
+		thread.name.resize(strnlen(thread.name.c_str(), thread.name.size()));
+	} else if (id == EV_STACK_USAGE) {
+		auto& thread = threads[param];
+		uint32_t used = event & 0xFFFFFF;
+		if (thread.peaks.size() == 0 || used > thread.peaks.back().used) {
+			thread.peaks.push_back({ time, used });
+		}
+	}
+}
+
+void StackStats::print(FILE* f)
+{
+	fprintf(f, "Thread      name                  size    peak   used[%%]\n");
+	for (auto& it : threads) {
+		auto& thread = it.second;
+		if (thread.peaks.size() == 0) {
+			fprintf(f, "0x%08X  %-20s  %6d       -         -\n", it.first, thread.name.c_str(), thread.size);
+			continue;
+		}
+		uint32_t peak = thread.peaks.back().used;
+		fprintf(f, "0x%08X  %-20s  %6d  %6d  %8.1f\n", it.first, thread.name.c_str(), thread.size, peak,
+			thread.size > 0 ? (double)peak * 100.0 / (double)thread.size : 0.0);
+		for (auto& p : thread.peaks) {
+			fprintf(f, "            at %12.6f s  %6d\n", (double)p.time / TIMER_FREQUENCY, p.used);
+		}
+	}
+}
+
+/*
+ * Downsamples counters and gauges into time series with fixed interval. Each interval that has
+ * samples contains number of samples, minimum, maximum, average and sum of the values. For
+ * counters, the sum is the amount added in the interval and the total is a running sum.
+ */
+class SeriesStats
+{
+public:
+	SeriesStats() : period(TIMER_FREQUENCY / 10) {}
+	void setPeriod(uint64_t periodMs) { period = std::max(periodMs * TIMER_FREQUENCY / 1000, (uint64_t)1); }
+	void process(uint64_t time, uint32_t event, uint32_t param);
+	void print(FILE* f);
+private:
+	struct Interval {
+		uint64_t samples;
+		uint32_t min;
+		uint32_t max;
+		uint64_t sum;
+		Interval() : samples(0), min(UINT32_MAX), max(0), sum(0) {}
+	};
+	// Key is event id with the counter or gauge id.
+	std::map<uint32_t, std::map<uint64_t, Interval> > series;
+	uint64_t period;
+};
+
+void SeriesStats::process(uint64_t time, uint32_t event, uint32_t param)
+{
+	uint32_t id = event & 0xFF000000;
+
+	if (id != EV_COUNTER && id != EV_GAUGE) {
+		return;
+	}
+
+	auto& interval = series[event][time / period];
+	interval.samples++;
+	interval.min = std::min(interval.min, param);
+	interval.max = std::max(interval.max, param);
+	interval.sum += param;
+}
+
+void SeriesStats::print(FILE* f)
+{
+	fprintf(f, "type,id,time[s],samples,min,max,avg,sum,total\n");
+	for (auto& s : series) {
+		const char *type = ((s.first & 0xFF000000) == EV_COUNTER) ? "counter" : "gauge";
+		uint64_t total = 0;
+		for (auto& it : s.second) {
+			auto& interval = it.second;
+			total += interval.sum;
+			fprintf(f, "%s,0x%06X,%.6f,%llu,%u,%u,%.2f,%llu,", type, s.first & 0xFFFFFF,
+				(double)(it.first * period) / TIMER_FREQUENCY, (unsigned long long)interval.samples,
+				interval.min, interval.max, (double)interval.sum / (double)interval.samples,
+				(unsigned long long)interval.sum);
+			if ((s.first & 0xFF000000) == EV_COUNTER) {
+				fprintf(f, "%llu\n", (unsigned long long)total);
+			} else {
+				fprintf(f, "\n");
+			}
+		}
+	}
+}
+
+/*
+ * Reports events lost because of RTT buffer overflows. Per-class counts come from EV_OVERFLOW_CLASS.
+ * Lost events not covered by them (target without drop stats) are unattributed and losses detected
+ * by the host have unknown count. Thread timeline is uncertain from the overflow until the next
+ * EV_THREAD_START or EV_IDLE if scheduling events may have been lost, so the threads running at
+ * both ends of such gap are reported.
+ */
+class LossStats
+{
+public:
+	LossStats() : overflows(0), lost(0), hostLosses(0), uncertainGaps(0), uncertainTime(0), currentThread(NO_THREAD),
+		gapOpen(false), gapTime(0), gapThread(NO_THREAD), gapClassesKnown(false), gapSched(false) {}
+	void process(uint64_t time, uint32_t event, uint32_t param, const std::basic_string<uint8_t> &buffer);
+	void print(FILE* f);
+	static std::string className(uint32_t cls);
+private:
+	static const uint32_t NO_THREAD = 0;
+	static const uint32_t CLASS_SCHED = 1;
+	struct Thread {
+		std::string name;
+		uint64_t gaps;
+		uint64_t uncertainTime;
+		Thread() : gaps(0), uncertainTime(0) {}
+	};
+	uint64_t overflows;
+	uint64_t lost;
+	uint64_t hostLosses;
+	uint64_t uncertainGaps;
+	uint64_t uncertainTime;
+	std::map<uint32_t, uint64_t> classes;
+	std::map<uint32_t, Thread> threads;
+	uint32_t currentThread;
+	// Gap in the trace that was not closed by a scheduling event yet.
+	bool gapOpen;
+	uint64_t gapTime;
+	uint32_t gapThread;
+	bool gapClassesKnown;
+	bool gapSched;
+
+	void openGap(uint64_t time, bool classesKnown);
+	void closeGap(uint64_t time, uint32_t nextThread);
+};
+
+std::string LossStats::className(uint32_t cls)
+{
+	static const char *names[] = { "system", "sched", "isr", "syscall", "user", "print", "info" };
+
+	if (cls < sizeof(names) / sizeof(names[0])) {
+		return names[cls];
+	}
+	return "class " + std::to_string(cls);
+}
+
+void LossStats::openGap(uint64_t time, bool classesKnown)
+{
+	if (gapOpen) {
+		gapClassesKnown = gapClassesKnown && classesKnown;
+		return;
+	}
+	gapOpen = true;
+	gapTime = time;
+	gapThread = currentThread;
+	gapClassesKnown = classesKnown;
+	gapSched = false;
+}
+
+void LossStats::closeGap(uint64_t time, uint32_t nextThread)
+{
+	if (!gapOpen) {
+		return;
+	}
+	gapOpen = false;
+	if (gapClassesKnown && !gapSched) {
+		return;
+	}
+	uint64_t duration = time - gapTime;
+	uncertainGaps++;
+	uncertainTime += duration;
+	if (gapThread != NO_THREAD) {
+		threads[gapThread].gaps++;
+		threads[gapThread].uncertainTime += duration;
+	}
+	if (nextThread != NO_THREAD && nextThread != gapThread) {
+		threads[nextThread].gaps++;
+		threads[nextThread].uncertainTime += duration;
+	}
+}
+
+void LossStats::process(uint64_t time, uint32_t event, uint32_t param, const std::basic_string<uint8_t> &buffer)
+{
+	uint32_t id = event & 0xFF000000;
+
+	if (id == EV_OVERFLOW) {
+		overflows++;
+		lost += param;
+		// Classes are known when EV_OVERFLOW_CLASS follows.
+		openGap(time, false);
+	} else if (id == EV_OVERFLOW_CLASS) {
+		classes[event & 0xFF] += param;
+		if (gapOpen) {
+			gapClassesKnown = true;
+			gapSched = gapSched || (event & 0xFF) == CLASS_SCHED;
+		}
+	} else if (id == EV_INTERNAL_OVERFLOW || id == EV_INTERNAL_CORRUPTED) {
+		hostLosses++;
+		openGap(time, false);
+		gapSched = true;
+	} else if (id == EV_SYSTEM_RESET) {
+		gapOpen = false;
+		currentThread = NO_THREAD;
+	} else if (id == EV_THREAD_START) {
+		closeGap(time, param);
+		currentThread = param;
+	} else if (id == EV_IDLE) {
+		closeGap(time, NO_THREAD);
+		currentThread = NO_THREAD;
+	} else if (id == EV_THREAD_INFO_END && buffer.size() >= 8) {
+		auto& thread = threads[param];
+		thread.name.assign((const char *)&buffer[8], buffer.size() - 8);
+		thread.name.resize(strnlen(thread.name.c_str(), thread.name.size()));
+	}
+}
+
+void LossStats::print(FILE* f)
+{
+	uint64_t attributed = 0;
+
+	fprintf(f, "Overflows: %llu, lost events: %llu, host detected losses: %llu\n", (unsigned long long)overflows,
+		(unsigned long long)lost, (unsigned long long)hostLosses);
+	fprintf(f, "Class           lost\n");
+	for (auto& it : classes) {
+		attributed += it.second;
+		fprintf(f, "%-10s  %8llu\n", className(it.first).c_str(), (unsigned long long)it.second);
+	}
+	if (lost > attributed) {
+		fprintf(f, "%-10s  %8llu\n", "unknown", (unsigned long long)(lost - attributed));
+	}
+	fprintf(f, "Uncertain thread timeline: %llu gaps, %.6f s\n", (unsigned long long)uncertainGaps,
+		(double)uncertainTime / TIMER_FREQUENCY);
+	fprintf(f, "Thread      name                  gaps  uncertain[s]\n");
+	for (auto& it : threads) {
+		auto& thread = it.second;
+		if (thread.gaps == 0) {
+			continue;
+		}
+		fprintf(f, "0x%08X  %-20s  %4llu  %12.6f\n", it.first, thread.name.c_str(), (unsigned long long)thread.gaps,
+			(double)thread.uncertainTime / TIMER_FREQUENCY);
+	}
+}
+
+/*
+ * Content-addressed store of blob payloads. Each distinct payload is compressed with zlib into a
+ * file named by its size and FNV-1a hash, so repeated payloads are stored only once, also across
+ * multiple decoder runs. Existing file with the same name is compared with the payload, so hash
+ * collision gets a next free suffix.
+ */
+class BlobStore
+{
+public:
+	BlobStore(const std::string &dir);
+	std::string store(const std::basic_string<uint8_t> &data);
+	void print(FILE* f);
+private:
+	std::string dir;
+	std::set<std::string> known;
+	uint64_t blobs;
+	uint64_t rawBytes;
+	uint64_t storedBytes;
+
+	bool sameContent(const std::string &path, const std::basic_string<uint8_t> &data);
+};
+
+BlobStore::BlobStore(const std::string &dir) : dir(dir), blobs(0), rawBytes(0), storedBytes(0)
+{
+	if (mkdir(dir.c_str(), 0777) < 0 && errno != EEXIST) {
+		FATAL("Cannot create blob store directory '%s'!", dir.c_str());
+	}
+}
+
+bool BlobStore::sameContent(const std::string &path, const std::basic_string<uint8_t> &data)
+{
+	std::basic_string<uint8_t> compressed;
+	std::basic_string<uint8_t> content(data.size(), 0);
+	uint8_t chunk[4096];
+	size_t len;
+	uLongf contentSize = content.size();
+
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == NULL) {
+		FATAL("Cannot open blob '%s'!", path.c_str());
+	}
+	while ((len = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+		compressed.append(chunk, len);
+	}
+	fclose(f);
+
+	return uncompress(&content[0], &contentSize, compressed.data(), compressed.size()) == Z_OK
+		&& contentSize == data.size() && content == data;
+}
+
+std::string BlobStore::store(const std::basic_string<uint8_t> &data)
+{
+	uint64_t hash = 14695981039346656037uLL;
+	char name[64];
+	std::string path;
+	struct stat st;
+
+	for (auto byte : data) {
+		hash = (hash ^ byte) * 1099511628211uLL;
+	}
+
+	blobs++;
+	rawBytes += data.size();
+
+	for (int suffix = 0; ; suffix++) {
+		snprintf(name, sizeof(name), "%08zx-%016llx-%d.z", data.size(), (unsigned long long)hash, suffix);
+		path = dir + "/" + name;
+		if (known.count(name) > 0) {
+			return name;
+		}
+		if (stat(path.c_str(), &st) < 0) {
+			break;
+		}
+		if (sameContent(path, data)) {
+			known.insert(name);
+			return name;
+		}
+	}
+
+	std::basic_string<uint8_t> compressed(compressBound(data.size()), 0);
+	uLongf compressedSize = compressed.size();
+	if (compress2(&compressed[0], &compressedSize, data.data(), data.size(), Z_BEST_COMPRESSION) != Z_OK) {
+		FATAL("Blob compression failed!");
+	}
+
+	// Write to temporary file first, so other decoder never sees incomplete blob.
+	std::string tmp = path + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if (f == NULL || fwrite(compressed.data(), 1, compressedSize, f) != compressedSize || fclose(f) != 0) {
+		FATAL("Cannot write blob '%s'!", tmp.c_str());
+	}
+	if (rename(tmp.c_str(), path.c_str()) < 0) {
+		FATAL("Cannot rename blob '%s'!", tmp.c_str());
+	}
+
+	known.insert(name);
+	storedBytes += compressedSize;
+	return name;
+}
+
+void BlobStore::print(FILE* f)
+{
+	fprintf(f, "Blobs: %llu, distinct: %zu, payload: %llu bytes, newly stored: %llu bytes\n",
+		(unsigned long long)blobs, known.size(), (unsigned long long)rawBytes, (unsigned long long)storedBytes);
+}
+
+class RamDump
+{
+public:
+	RamDump(const std::string &file_name, uint32_t base_address);
+	std::string recover(uint32_t ring_size);
+private:
+	struct Segment {
+		uint32_t address;
+		std::basic_string<uint8_t> data;
+	};
+	std::vector<Segment> segments;
+	void loadBinary(FILE* f, uint32_t base_address);
+	void loadIntelHex(FILE* f);
+	void append(uint32_t address, const uint8_t *data, size_t size);
+	static uint32_t word(const std::basic_string<uint8_t> &data, size_t pos);
+	static bool isValidEvent(uint32_t event);
+};
+
+RamDump::RamDump(const std::string &file_name, uint32_t base_address)
+{
+	int c;
+	FILE* f = fopen(file_name.c_str(), "rb");
+	if (f == NULL) {
+		FATAL("Cannot open RAM dump file");
+	}
+	c = fgetc(f);
+	rewind(f);
+	if (c == ':') {
+		loadIntelHex(f);
+	} else {
+		loadBinary(f, base_address);
+	}
+	fclose(f);
+}
+
+void RamDump::append(uint32_t address, const uint8_t *data, size_t size)
+{
+	if (segments.size() == 0 || segments.back().address + segments.back().data.size() != address) {
+		segments.push_back(Segment());
+		segments.back().address = address;
+	}
+	segments.back().data.append(data, size);
+}
+
+void RamDump::loadBinary(FILE* f, uint32_t base_address)
+{
+	uint8_t buffer[4096];
+	uint32_t address = base_address;
+	size_t len;
+
+	while ((len = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+		append(address, buffer, len);
+		address += len;
+	}
+}
+
+void RamDump::loadIntelHex(FILE* f)
+{
+	char line[1024];
+	uint8_t bytes[256 + 5];
+	uint32_t upper = 0;
+	unsigned int value;
+	size_t len;
+	size_t i;
+	uint8_t sum;
+
+	while (fgets(line, sizeof(line), f)) {
+		len = strlen(line);
+		while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == '\n')) {
+			len--;
+		}
+		if (len == 0) {
+			continue;
+		}
+		if (line[0] != ':' || len < 11 || (len & 1) == 0 || (len - 1) / 2 > sizeof(bytes)) {
+			FATAL("Invalid Intel HEX line: %s", line);
+		}
+		sum = 0;
+		for (i = 0; i < (len - 1) / 2; i++) {
+			if (sscanf(&line[1 + 2 * i], "%2x", &value) != 1) {
+				FATAL("Invalid Intel HEX line: %s", line);
+			}
+			bytes[i] = value;
+			sum += value;
+		}
+		if (sum != 0 || bytes[0] + 5 != (len - 1) / 2) {
+			FATAL("Invalid Intel HEX checksum: %s", line);
+		}
+		switch (bytes[3]) {
+		case 0x00:
+			append(upper + ((uint32_t)bytes[1] << 8) + bytes[2], &bytes[4], bytes[0]);
+			break;
+		case 0x01:
+			return;
+		case 0x02:
+			upper = (((uint32_t)bytes[4] << 8) | bytes[5]) << 4;
+			break;
+		case 0x04:
+			upper = (((uint32_t)bytes[4] << 8) | bytes[5]) << 16;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+uint32_t RamDump::word(const std::basic_string<uint8_t> &data, size_t pos)
+{
+	uint32_t result;
+	memcpy(&result, &data[pos], sizeof(result));
+	return result;
+}
+
+bool RamDump::isValidEvent(uint32_t event)
+{
+	uint32_t id = event & 0xFF000000;
+
+	return (id >= EV_CYCLE && id <= EV_RES_NAME)
+		|| (id >= EV_CLASS_MASK && id <= EV_PRINT)
+		|| (id >= _RTT_LITE_TRACE_EV_MARK_START && id <= _RTT_LITE_TRACE_EV_USER_LAST)
+		|| id == EV_BLOB
+		|| id == EV_KEEPALIVE
+		|| id == EV_ISR_COUNT
+		|| id == EV_STACK_USAGE
+		|| id == EV_COUNTER
+		|| id == EV_GAUGE
+		|| id == EV_OVERFLOW_CLASS
+		|| (id & 0x80000000);
+}
+
+/*
+ * Finds flight recorder RTT buffer in the dump and writes its events in chronological order
+ * to a temporary log file. The buffer is recognized by the EV_CYCLE event placed after its end.
+ * The EV_CYCLE contains write index in the additional field and cycle counter in the param.
+ */
+std::string RamDump::recover(uint32_t ring_size)
+{
+	const Segment *best = NULL;
+	size_t bestEnd = 0;
+	uint32_t bestSize = 0;
+	uint32_t bestCount = 0;
+	uint32_t minSize = ring_size ? ring_size : 512;
+	uint32_t maxSize = ring_size ? ring_size : 65536;
+
+	for (auto& seg : segments) {
+		for (size_t end = 0; end + 8 <= seg.data.size(); end += 4) {
+			uint32_t cycle = word(seg.data, end);
+			uint32_t counter = word(seg.data, end + 4);
+			uint32_t index = cycle & 0x00FFFFFF;
+			if ((cycle & 0xFF000000) != EV_CYCLE || (counter & 1) == 0 || (index & 7) != 0) {
+				continue;
+			}
+			for (uint32_t size = minSize; size <= maxSize && size <= end; size <<= 1) {
+				uint32_t used = (counter > 1) ? size : index;
+				uint32_t valid = 0;
+				if (index >= size || used == 0) {
+					continue;
+				}
+				for (uint32_t pos = 0; pos < used; pos += 8) {
+					valid += isValidEvent(word(seg.data, end - size + pos));
+				}
+				// Smaller candidates with the same end are also valid, so prefer the biggest one.
+				if (valid * 10 >= (used / 8) * 9 && valid >= bestCount) {
+					best = &seg;
+					bestEnd = end;
+					bestSize = size;
+					bestCount = valid;
+				}
+			}
+		}
+	}
+
+	if (best == NULL) {
+		FATAL("Cannot find flight recorder RTT buffer in the RAM dump");
+	}
+
+	const uint8_t *ring = &best->data[bestEnd - bestSize];
+	uint32_t index = word(best->data, bestEnd) & 0x00FFFFFF;
+	uint32_t counter = word(best->data, bestEnd + 4);
+	char name[] = "/tmp/rtt_lite_trace_XXXXXX";
+	int fd = mkstemp(name);
+	FILE* f = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+	if (f == NULL) {
+		FATAL("Cannot create temporary file");
+	}
+
+	fprintf(f, "# RAM dump: buffer at 0x%08X, size %d, write index %d, cycle %d\r\n",
+		(uint32_t)(best->address + bestEnd - bestSize), bestSize, index, counter >> 1);
+	fprintf(stderr, "RAM dump: buffer at 0x%08X, size %d, write index %d, cycle %d\n",
+		(uint32_t)(best->address + bestEnd - bestSize), bestSize, index, counter >> 1);
+
+	if (counter > 1) {
+		// Oldest events were written in the previous cycle, so start with its counter
+		// to avoid overflow detection before the first EV_CYCLE.
+		uint32_t start[2] = { EV_CYCLE, counter - 2 };
+		fwrite(start, 1, sizeof(start), f);
+		fwrite(&ring[index], 1, bestSize + 8 - index, f);
+	}
+	fwrite(ring, 1, index, f);
+	fclose(f);
+
+	return name;
+}
+
+int main(int argc, char *argv[])
+{
+	static const struct option long_options[] = {
+		{ "dump", required_argument, NULL, 'd' },
+		{ "base", required_argument, NULL, 'b' },
+		{ "size", required_argument, NULL, 's' },
+		{ "last", required_argument, NULL, 'n' },
+		{ "isr-stats", no_argument, NULL, 'i' },
+		{ "stack-usage", no_argument, NULL, 'k' },
+		{ "series", required_argument, NULL, 't' },
+		{ "blob-store", required_argument, NULL, 'B' },
+		{ "loss-stats", no_argument, NULL, 'l' },
+		{ "stats-file", required_argument, NULL, 'S' },
+		{ NULL, 0, NULL, 0 },
+	};
+	std::vector<std::string> files;
+	const char *dump = NULL;
+	uint32_t dumpBase = 0;
+	uint32_t ringSize = 0;
+	uint64_t last = 0;
+	uint64_t skip = 0;
+	bool isrStats = false;
+	bool stackUsage = false;
+	bool series = false;
+	uint64_t seriesPeriod = 0;
+	std::unique_ptr<BlobStore> blobStore;
+	bool loss = false;
+	int c;
+
+	while ((c = getopt_long(argc, argv, "d:b:s:n:ikt:B:lS:", long_options, NULL)) >= 0) {
+		switch (c) {
+		case 'd':
+			dump = optarg;
+			break;
+		case 'b':
+			dumpBase = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			ringSize = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			last = strtoull(optarg, NULL, 0);
+			break;
+		case 'i':
+			isrStats = true;
+			break;
+		case 'k':
+			stackUsage = true;
+			break;
+		case 't':
+			series = true;
+			seriesPeriod = strtoull(optarg, NULL, 0);
+			break;
+		case 'B':
+			blobStore.reset(new BlobStore(optarg));
+			break;
+		case 'l':
+			loss = true;
+			break;
+		case 'S':
+			pipelineStats.setFile(optarg);
+			break;
+		default:
+			FATAL("Usage: %s [-d dump [-b base] [-s size]] [-n last] [-i] [-k] [-t period_ms] [-B blob_dir] [-l] [-S stats_file] [file...]", argv[0]);
+		}
+	}
+
+	// Each RTT channel is logged into separate file, the first one is the main channel.
+	if (dump != NULL) {
+		RamDump ram(dump, dumpBase);
+		files.push_back(ram.recover(ringSize));
+	}
+	for (int i = optind; i < argc; i++) {
+		files.push_back(argv[i]);
+	}
+	if (files.size() == 0) {
+		files.push_back("./test.log");
+	}
+
+	// Merged multi-board capture is a single file, statistics are collected for each board.
+	BoardMerge reader(files);
 	std::basic_string<uint8_t> buf;
+	std::vector<IsrStats> stats(reader.getBoardCount());
+	std::vector<StackStats> stackStats(reader.getBoardCount());
+	std::vector<SeriesStats> seriesStats(reader.getBoardCount());
+	std::vector<LossStats> lossStats(reader.getBoardCount());
+	std::string boardPrefix;
+
+	if (series) {
+		for (auto& s : seriesStats) {
+			s.setPeriod(seriesPeriod);
+		}
+	}
 
 	uint32_t event;
 	uint32_t param;
 	uint64_t time;
+	uint32_t board;
 	int i = 0;
 
-	while (reader.readEvent(time, event, param, buf)) {
+	if (last > 0) {
+		BoardMerge counter(files);
+		uint64_t total = 0;
+		while (counter.readEvent(time, event, param, buf, board)) {
+			total++;
+		}
+		buf.clear();
+		skip = (total > last) ? total - last : 0;
+	}
+
+	while (reader.readEvent(time, event, param, buf, board)) {
+		if (isrStats) {
+			stats[board].process(time, event, param);
+		}
+		if (stackUsage) {
+			stackStats[board].process(time, event, param, buf);
+		}
+		if (series) {
+			seriesStats[board].process(time, event, param);
+		}
+		if (loss) {
+			lossStats[board].process(time, event, param, buf);
+		}
+		if (skip > 0) {
+			skip--;
+			buf.clear();
+			continue;
+		}
+		if (reader.isMerged()) {
+			boardPrefix = "Board " + std::to_string(board) + ": ";
+		}
 		if ((event & 0xFF000000) == EV_OVERFLOW) {
-			printf("Overflow %d\n", param);
+			printf("%sOverflow %d\n", boardPrefix.c_str(), param);
+		} else if ((event & 0xFF000000) == EV_OVERFLOW_CLASS) {
+			printf("%sOverflow %s %d\n", boardPrefix.c_str(), LossStats::className(event & 0xFF).c_str(), param);
+		} else if ((event & 0xFF000000) == EV_CLASS_MASK) {
+			printf("%sClass mask 0x%08X\n", boardPrefix.c_str(), param);
+		} else if ((event & 0xFF000000) == EV_BLOB && blobStore) {
+			printf("%s%10d  0x%08X  0x%08X    blob %zu bytes: %s\n", boardPrefix.c_str(), (int)time, event, param, buf.size(),
+				blobStore->store(buf).c_str());
+			buf.clear();
 		} else if (buf.size() > 0) {
-			printf("%10d  0x%08X  0x%08X   ", (int)time, event, param);
+			printf("%s%10d  0x%08X  0x%08X   ", boardPrefix.c_str(), (int)time, event, param);
 			for (int k = 0; k < buf.size(); k++) {
 				printf(" %02X", buf[k]);
 			}
@@ -788,6 +2206,32 @@ int main()
 		//if (i == 20) break;
 	}
 
+	for (board = 0; board < reader.getBoardCount(); board++) {
+		if (reader.isMerged() && (isrStats || stackUsage || series || loss)) {
+			printf("\nBoard %u\n", board);
+		}
+		if (isrStats) {
+			stats[board].print(stdout);
+		}
+		if (stackUsage) {
+			stackStats[board].print(stdout);
+		}
+		if (series) {
+			seriesStats[board].print(stdout);
+		}
+		if (loss) {
+			lossStats[board].print(stdout);
+		}
+	}
+	if (blobStore) {
+		blobStore->print(stdout);
+	}
+	pipelineStats.publish();
+
+	if (dump != NULL) {
+		unlink(files[0].c_str());
+	}
+
 	return 0;
 }
 
@@ -12,6 +12,8 @@
 #include <netinet/in.h>
 #include "dyn_nrfjprogdll.h"
 
+// Maximum number of boards captured at once.
+#define MAX_BOARDS 8
 
 struct options_t
 {
@@ -20,6 +22,9 @@ struct options_t
     const char *iface;
 
     uint32_t snr;
+    // All serial numbers given by --snr, more than one starts multi-board capture.
+    uint32_t snr_list[MAX_BOARDS];
+    uint32_t snr_count;
     device_family_t family;
     uint32_t speed;
     uint32_t rtt_cb_address;
@@ -27,9 +32,31 @@ struct options_t
     const char* nrfjprog_lib;
 
     uint32_t poll_time_us;
+    uint32_t poll_min_us;
     bool no_rtt_retry;
 
     const char* hang_file;
+
+    bool class_mask_set;
+    uint32_t class_mask;
+
+    const char* output_file;
+    // Output segment limits, zero if not used.
+    uint64_t rotate_size;
+    uint32_t rotate_time_s;
+    // Total size of the on-disk ring of segments, zero if output is not a ring.
+    uint64_t keep_size;
+    uint32_t ring_size;
+
+    const char* source;
+    uint32_t replay_speed;
+
+    // Port of SystemView live streaming server, zero if disabled.
+    uint16_t sysview_port;
+
+    // Self-instrumentation outputs, NULL if not used.
+    const char* stats_file;
+    const char* stats_socket;
 };
 
 extern struct options_t options;
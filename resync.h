@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _resync_h_
+#define _resync_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Number of consecutive valid events that confirm the event boundary.
+#define RESYNC_EVENTS 32
+
+// Data collected after reconnect before the boundary is searched. Events take at most 8 bytes.
+#define RESYNC_WINDOW (2 * 8 * RESYNC_EVENTS)
+
+// Number of valid events that confirm the boundary if no more data is coming.
+#define RESYNC_MIN_EVENTS 8
+
+/*
+ * Finds event boundary in the stream that may start in the middle of an
+ * event, e.g. after reconnect. Target writes events at 4-byte aligned RTT
+ * indexes, so data must begin at one of them and only offsets aligned to
+ * 4 bytes are checked. Target does not send sync events, so the
+ * boundary is recognized by framing: it is full event with time stamp and
+ * RESYNC_EVENTS events from it must have valid ids and their time stamps
+ * must go forward. Params and buffer data may look like events too, so the
+ * boundary found may be a few events early, but the framing after them is
+ * correct. Returns offset of the first such boundary or SIZE_MAX if there is
+ * none.
+ */
+size_t resync_find(const uint8_t *data, size_t size);
+
+/*
+ * The same as resync_find(), but for data that is not followed by more data
+ * soon, e.g. from quiet target or at the end of capture. Boundary may be
+ * confirmed by all events up to the end of data, if there are at least
+ * RESYNC_MIN_EVENTS of them.
+ */
+size_t resync_find_end(const uint8_t *data, size_t size);
+
+#endif
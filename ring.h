@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _ring_h_
+#define _ring_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*
+ * Lock-free single-producer/single-consumer byte ring. Read and write indexes
+ * are free running and the size is a power of two, so the fill level is
+ * always write - read. The producer owns the write index and the consumer owns
+ * the read index, each side only loads the other one.
+ */
+struct ring
+{
+    uint8_t *data;
+    size_t size;
+    size_t mask;
+    _Atomic size_t write_index;
+    _Atomic size_t read_index;
+    // Statistics updated by the producer.
+    size_t max_used;
+};
+
+bool ring_init(struct ring *ring, size_t size);
+void ring_free(struct ring *ring);
+
+// Producer side: get contiguous free space and commit bytes written into it.
+uint8_t *ring_write_ptr(struct ring *ring, size_t *size);
+void ring_commit(struct ring *ring, size_t size);
+
+// Consumer side: get contiguous data and release bytes already processed.
+const uint8_t *ring_read_ptr(struct ring *ring, size_t *size);
+void ring_release(struct ring *ring, size_t size);
+
+size_t ring_used(struct ring *ring);
+
+#endif
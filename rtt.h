@@ -16,5 +16,8 @@ bool nrfjprog_init();
 
 void write_queue();
 uint32_t rtt_read(char * data, uint32_t data_len);
+uint32_t rtt_read_info(char * data, uint32_t data_len);
+uint32_t rtt_channel_size();
+bool rtt_write_command(uint32_t command, uint32_t param);
 
 #endif
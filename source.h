@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _source_h_
+#define _source_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Returned by read() when the source will not provide any more data.
+#define SOURCE_END (-1)
+
+/*
+ * Source of the trace byte stream. Functions are called from the capture
+ * process only, so each backend keeps its state in static variables. Errors
+ * after which the source should be opened again exit the process with
+ * RECOVERABLE_EXIT_CODE, like the nrfjprog backend always did.
+ */
+struct trace_source
+{
+    const char *name;
+    // Opens the source, argument is the part of --source after the name.
+    void (*open)(const char *arg);
+    // Reads available data without blocking. Returns number of bytes or SOURCE_END.
+    int32_t (*read)(uint8_t *data, uint32_t size);
+    // Reads available data of the info channel, NULL if the source has one channel only.
+    int32_t (*read_info)(uint8_t *data, uint32_t size);
+    // Size of the target buffer or preferred read size, zero if unknown.
+    uint32_t (*buffer_size)(void);
+    void (*close)(void);
+};
+
+extern const struct trace_source nrfjprog_source;
+extern const struct trace_source file_source;
+extern const struct trace_source tcp_source;
+extern const struct trace_source unix_source;
+
+const struct trace_source *trace_source_find(const char *spec, const char **arg);
+
+#endif
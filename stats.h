@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _stats_h_
+#define _stats_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*
+ * Threads of the capture pipeline. Each one updates only its own block of
+ * counters, so no locking is needed. Capture process started by the
+ * supervising process takes blocks of the reader and capture threads.
+ */
+enum stats_thread
+{
+    STATS_READER,
+    STATS_CAPTURE,
+    STATS_PROCESSING,
+    STATS_WRITER,
+    STATS_THREADS,
+};
+
+
+enum stats_counter
+{
+    STATS_BYTES,
+    STATS_EVENTS,
+    STATS_POLLS,
+    STATS_READS,
+    STATS_FULL_POLLS,
+    STATS_LATE_POLLS,
+    STATS_POLL_TIME_US,
+    STATS_POLL_TIME_MAX_US,
+    STATS_POLL_DELAY_MAX_US,
+    STATS_RESYNCS,
+    STATS_SKIPPED_BYTES,
+    STATS_OVERFLOWS,
+    STATS_RESETS,
+    STATS_RESTARTS,
+    STATS_WRITES,
+    STATS_BUFFER_WAITS,
+    STATS_COUNTERS,
+};
+
+
+struct stats_block
+{
+    _Atomic uint64_t values[STATS_COUNTERS];
+};
+
+
+// Block of the calling thread, NULL if statistics are disabled.
+extern __thread struct stats_block *stats_local;
+
+
+/*
+ * Counters are written by the owner thread only, so relaxed load and store
+ * is enough and it does not need a locked instruction.
+ */
+static inline void stats_add(enum stats_counter counter, uint64_t value)
+{
+    if (stats_local != NULL)
+    {
+        atomic_store_explicit(&stats_local->values[counter],
+            atomic_load_explicit(&stats_local->values[counter], memory_order_relaxed) + value,
+            memory_order_relaxed);
+    }
+}
+
+
+static inline void stats_max(enum stats_counter counter, uint64_t value)
+{
+    if (stats_local != NULL
+        && value > atomic_load_explicit(&stats_local->values[counter], memory_order_relaxed))
+    {
+        atomic_store_explicit(&stats_local->values[counter], value, memory_order_relaxed);
+    }
+}
+
+
+/*
+ * Self-instrumentation of the host pipeline. Counters are periodically
+ * collected by the data processing thread and published to the stats file
+ * and to clients of the stats socket. Blocks are in shared memory, so
+ * counters of the capture process are seen by the supervising process.
+ */
+void stats_init(void);
+void stats_thread(enum stats_thread thread);
+void stats_poll(void);
+void stats_release(void);
+void stats_close(void);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _sysview_h_
+#define _sysview_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Port where SystemView application connects to the recorder by default.
+#define SYSVIEW_DEFAULT_PORT 19111
+
+/*
+ * SystemView live streaming server. Trace events are converted to SystemView
+ * packets by the SEGGER SystemView module and sent to all connected clients.
+ * All functions are called from the data processing thread only.
+ */
+void sysview_init(uint16_t port);
+void sysview_event(uint32_t event, uint32_t param, uint64_t receive_time);
+void sysview_gap(uint32_t last_time_stamp, uint64_t receive_time);
+void sysview_flush(void);
+void sysview_poll(void);
+void sysview_close(void);
+void sysview_release(void);
+
+#endif
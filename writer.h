@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _writer_h_
+#define _writer_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Raw capture writer. Data is collected in large page aligned buffers that
+ * are written to the file by a background thread, so slow disk never delays
+ * data processing. Output may be split into segments rotated by size or
+ * time. With --keep output is a ring of segments that keeps only the newest
+ * data, which can be exported as one file in the background. Each segment
+ * starts with "# ..." header lines, which include the time stamp frequency
+ * if it is known, so each segment can be decoded on its own. Functions
+ * other than the writer and export threads themselves are called from the
+ * data processing thread only.
+ */
+void writer_open(const char *path, uint32_t session, uint32_t frequency);
+void writer_write(const uint8_t *data, size_t size);
+bool writer_rotation_due(size_t size);
+void writer_rotate(uint32_t session, uint32_t frequency);
+void writer_poll(void);
+void writer_export(const uint8_t *dictionary, size_t dictionary_size);
+void writer_close(void);
+
+#endif